@@ -25,6 +25,7 @@ MP1Node::MP1Node(Member *member, Params *params, EmulNet *emul, Log *log, Addres
     this->log = log;
     this->par = params;
     this->memberNode->addr = *address;
+    this->lastFullSync = 0;
 }
 
 /**
@@ -162,7 +163,7 @@ int MP1Node::finishUpThisNode() {
     memberNode->inGroup = false;
     memberNode->inited = false;
     memberNode->heartbeat = 0;
-    memberNode->memberList.clear();
+    initMemberListTable(memberNode);
     return 0;
 }
 
@@ -237,46 +238,29 @@ bool MP1Node::recvCallBack(void *env, char *data, int size) {
         log->LOG(&memberNode->addr, s);
 #endif
         // add to membership list
-        bool found = false;
-        for (auto &entry : memberNode->memberList) {
-            if (entry.getid() == id) {
-                found = true;
-                // update info
-                entry.setport(port);
-                entry.setheartbeat(heartbeat);
-                entry.settimestamp(par->getcurrtime());
-                break;
-            }
-        }
-        // add new entry
-        if (!found) {
-            MemberListEntry newEntry;
-            newEntry.setid(id);
-            newEntry.setport(port);
-            newEntry.setheartbeat(heartbeat);
-            newEntry.settimestamp(par->getcurrtime());
-
-            memberNode->memberList.push_back(newEntry);
+        MemberListEntry *entry = findMember(id);
+        if (entry != NULL) {
+            // update info
+            entry->setport(port);
+            entry->setheartbeat(heartbeat);
+            entry->settimestamp(par->getcurrtime());
+        } else {
+            // add new entry
+            MemberListEntry newEntry(id, port, heartbeat, par->getcurrtime());
+            addMember(newEntry);
             log->logNodeAdd(&memberNode->addr, &sender);
         }
-        // send a message back
-        MessageHdr *msg;
-        size_t memberListSize = sizeof(MemberListEntry) * memberNode->memberList.size();
-        size_t msgSize = sizeof(MessageHdr) + sizeof(memberNode->addr.addr) + 1 + memberListSize;
-        msg = (MessageHdr*) malloc(msgSize * sizeof(char));
-        // type header
-        msg->msgType = JOINREP;
-        offset = sizeof(MessageHdr);
-        // addr
-        memcpy((char*)msg + offset, &memberNode->addr.addr, sizeof(memberNode->addr.addr));
-        offset += sizeof(memberNode->addr.addr) + 1;
-        // member list
-        memcpy((char*)msg + offset, serializeMemberList(), memberListSize);
-        emulNet->ENsend(&memberNode->addr, &sender, (char*)msg, msgSize);
-        free(msg);
+        // spread the newcomer with the next gossips
+        markChanged(id);
+        // send the whole table back
+        sendMemberList(JOINREP, &sender, memberNode->memberList);
     } else if (msg_type == JOINREP) {
         // response from introducer, update membership list
-        memberNode->memberList = deserializeMemberList(data, size);
+        initMemberListTable(memberNode);
+        auto x_memberList = deserializeMemberList(data, size);
+        for (auto &x_entry : x_memberList) {
+            addMember(x_entry);
+        }
         memberNode->inGroup = true;
 #ifdef DEBUGLOG
         static char s[1024];
@@ -295,20 +279,18 @@ bool MP1Node::recvCallBack(void *env, char *data, int size) {
                 // myself
                 continue;
             }
-            auto m_entry_iter = std::find_if(memberNode->memberList.begin(),
-                                        memberNode->memberList.end(),
-                                        [&x_entry](MemberListEntry &entry)->bool {
-                                            return x_entry.getid() == entry.getid();
-                                        });
-            if (m_entry_iter != memberNode->memberList.end()) {
-                if (m_entry_iter->getheartbeat() < x_entry.getheartbeat()) {
-                    m_entry_iter->settimestamp(x_entry.gettimestamp());
-                    m_entry_iter->setheartbeat(x_entry.getheartbeat());
+            MemberListEntry *m_entry = findMember(x_entry.getid());
+            if (m_entry != NULL) {
+                if (m_entry->getheartbeat() < x_entry.getheartbeat()) {
+                    m_entry->settimestamp(x_entry.gettimestamp());
+                    m_entry->setheartbeat(x_entry.getheartbeat());
+                    markChanged(x_entry.getid());
                 }
             } else {
                 // add new entry
                 if (par->getcurrtime() - x_entry.gettimestamp() < par->EN_GPSZ*2) {
-                    memberNode->memberList.push_back(x_entry);
+                    addMember(x_entry);
+                    markChanged(x_entry.getid());
                     Address x_addr = makeAddress(x_entry.getid(), x_entry.getport());
                     log->logNodeAdd(&memberNode->addr, &x_addr);
                 }
@@ -325,14 +307,128 @@ Address MP1Node::makeAddress(int id, short port) const {
     return ret_addr;
 }
 
-char* MP1Node::serializeMemberList() {
-    size_t numEntry = memberNode->memberList.size();
-    size_t entrySize = sizeof(MemberListEntry);
-    MemberListEntry *ret = (MemberListEntry*) malloc(numEntry*entrySize*sizeof(char));
-    for (size_t i = 0; i < numEntry; ++i) {
-        memcpy((char*)(ret+i), &(memberNode->memberList[i]), entrySize);
+/**
+ * FUNCTION NAME: findMember
+ *
+ * DESCRIPTION: Entry of node id in the membership table, or NULL
+ */
+MemberListEntry* MP1Node::findMember(int id) {
+    auto slot = memberIndex.find(id);
+    if (slot == memberIndex.end()) {
+        return NULL;
+    }
+    return &memberNode->memberList[slot->second];
+}
+
+/**
+ * FUNCTION NAME: addMember
+ *
+ * DESCRIPTION: Appends entry to the membership table and indexes it
+ */
+void MP1Node::addMember(MemberListEntry &entry) {
+    memberIndex[entry.getid()] = memberNode->memberList.size();
+    memberNode->memberList.push_back(entry);
+}
+
+/**
+ * FUNCTION NAME: removeMember
+ *
+ * DESCRIPTION: Drops the entry in slot; the last entry moves into its place
+ */
+void MP1Node::removeMember(size_t slot) {
+    vector<MemberListEntry> &memberList = memberNode->memberList;
+    memberIndex.erase(memberList[slot].getid());
+    lastGossip.erase(memberList[slot].getid());
+    lastChanged.erase(memberList[slot].getid());
+    if (slot + 1 != memberList.size()) {
+        memberList[slot] = memberList.back();
+        memberIndex[memberList[slot].getid()] = slot;
+    }
+    memberList.pop_back();
+}
+
+/**
+ * FUNCTION NAME: markChanged
+ *
+ * DESCRIPTION: Puts node id's entry in the gossip deltas of the next gossipHotTicks() ticks.
+ * 				A heartbeat only needs to reach everyone a few times per failTimeout(),
+ * 				so an entry goes in at most once per failTimeout()/6 ticks; that keeps
+ * 				the deltas at O(log n) entries however often heartbeats advance.
+ */
+void MP1Node::markChanged(int id) {
+    long now = par->getcurrtime();
+    auto last = lastChanged.find(id);
+    if (last != lastChanged.end() && now - last->second < failTimeout()/6) {
+        return;
     }
-    return (char*)ret;
+    lastChanged[id] = now;
+    changeLog.push_back(make_pair(now, id));
+}
+
+/**
+ * FUNCTION NAME: failTimeout
+ *
+ * DESCRIPTION: Ticks without a newer heartbeat before a member is removed
+ */
+long MP1Node::failTimeout() const {
+    return par->EN_GPSZ*2+20;
+}
+
+/**
+ * FUNCTION NAME: gossipHotTicks
+ *
+ * DESCRIPTION: How long a change is pushed to one random peer per tick: log2(n) + ln(n)
+ * 				rounds reach every node with high probability. Peers it misses
+ * 				catch up at the next full sync or the next heartbeat.
+ */
+long MP1Node::gossipHotTicks() const {
+    return (long)ceil(log2(par->EN_GPSZ + 1) + ::log(par->EN_GPSZ + 1)) + 1;
+}
+
+/**
+ * FUNCTION NAME: gossipDelta
+ *
+ * DESCRIPTION: Entries changed within gossipHotTicks() and not already gossiped to peerId since
+ */
+vector<MemberListEntry> MP1Node::gossipDelta(int peerId) {
+    long since = par->getcurrtime() - gossipHotTicks();
+    auto last = lastGossip.find(peerId);
+    if (last != lastGossip.end() && last->second > since) {
+        since = last->second;
+    }
+
+    vector<MemberListEntry> delta;
+    unordered_set<int> seen;
+    for (auto change = changeLog.rbegin(); change != changeLog.rend() && change->first > since; ++change) {
+        MemberListEntry *entry = findMember(change->second);
+        if (entry != NULL && seen.insert(change->second).second) {
+            delta.push_back(*entry);
+        }
+    }
+    return delta;
+}
+
+/**
+ * FUNCTION NAME: sendMemberList
+ *
+ * DESCRIPTION: Sends entries as a JOINREP or GOSSIP message
+ */
+void MP1Node::sendMemberList(MsgTypes msgType, Address *toAddr, vector<MemberListEntry> &entries) {
+    size_t memberListSize = sizeof(MemberListEntry) * entries.size();
+    size_t msgSize = sizeof(MessageHdr) + sizeof(memberNode->addr.addr) + 1 + memberListSize;
+    MessageHdr *msg = (MessageHdr*) malloc(msgSize * sizeof(char));
+    // type header
+    msg->msgType = msgType;
+    size_t offset = sizeof(MessageHdr);
+    // addr
+    memcpy((char*)msg + offset, &memberNode->addr.addr, sizeof(memberNode->addr.addr));
+    offset += sizeof(memberNode->addr.addr) + 1;
+    // member list
+    if (memberListSize > 0) {
+        memcpy((char*)msg + offset, &entries[0], memberListSize);
+    }
+    emulNet->ENsend(&memberNode->addr, toAddr, (char*)msg, msgSize);
+    free(msg);
 }
 
 vector<MemberListEntry> MP1Node::deserializeMemberList(char *data, size_t size) {
@@ -348,24 +444,36 @@ vector<MemberListEntry> MP1Node::deserializeMemberList(char *data, size_t size)
     return ret;
 }
 
+/**
+ * FUNCTION NAME: sendGossip
+ *
+ * DESCRIPTION: Sends a random peer what changed since we last gossiped to it, or,
+ * 				once every failTimeout()/2 ticks, the whole table
+ */
 void MP1Node::sendGossip() {
-    int randomId = rand() % memberNode->memberList.size();
-    auto &m_entry = memberNode->memberList[randomId];
-    Address toAddr = makeAddress(m_entry.getid(), m_entry.getport());
-    // make a gossip message
-    size_t memberListSize = sizeof(MemberListEntry) * memberNode->memberList.size();
-    size_t msgSize = sizeof(MessageHdr) + sizeof(memberNode->addr.addr) + 1 + memberListSize;
-    MessageHdr *msg = (MessageHdr*) malloc(msgSize * sizeof(char));
-    // type header
-    msg->msgType = GOSSIP;
-    size_t offset = sizeof(MessageHdr);
-    // addr
-    memcpy((char*)msg + offset, &memberNode->addr.addr, sizeof(memberNode->addr.addr));
-    offset += sizeof(memberNode->addr.addr) + 1;
-    // member list
-    memcpy((char*)msg + offset, serializeMemberList(), memberListSize);
-    emulNet->ENsend(&memberNode->addr, &toAddr, (char*)msg, msgSize);
-    free (msg);
+    vector<MemberListEntry> &memberList = memberNode->memberList;
+    if (memberList.size() < 2) {
+        return;
+    }
+    // pick a peer other than myself
+    size_t mySlot = memberIndex[*(int*)(&memberNode->addr)];
+    size_t randomId = rand() % (memberList.size() - 1);
+    if (randomId >= mySlot) {
+        ++ randomId;
+    }
+    int peerId = memberList[randomId].getid();
+    Address toAddr = makeAddress(peerId, memberList[randomId].getport());
+
+    if (par->getcurrtime() - lastFullSync >= failTimeout()/2) {
+        lastFullSync = par->getcurrtime();
+        sendMemberList(GOSSIP, &toAddr, memberList);
+    } else {
+        vector<MemberListEntry> delta = gossipDelta(peerId);
+        if (!delta.empty()) {
+            sendMemberList(GOSSIP, &toAddr, delta);
+        }
+    }
+    lastGossip[peerId] = par->getcurrtime();
 }
 
 /**
@@ -377,28 +485,33 @@ void MP1Node::sendGossip() {
  */
 void MP1Node::nodeLoopOps() {
     // wangh
+    int m_id = *(int*)(&memberNode->addr.addr);
+    short m_port = *(short*)(&memberNode->addr.addr[4]);
     // scan for dead node
     for (size_t i = 0; i < memberNode->memberList.size(); ++i) {
         auto entry = memberNode->memberList[i];
-        if (entry.getid() == *(int*)(&memberNode->addr)) {
-            // myself, remove for now
-            memberNode->memberList.erase(memberNode->memberList.begin() + i);
+        if (entry.getid() != m_id && par->getcurrtime() - entry.gettimestamp() > failTimeout()) {
+            Address x_addr = makeAddress(entry.getid(), entry.getport());
+            log->logNodeRemove(&memberNode->addr, &x_addr);
+            removeMember(i);
             -- i;
-        } else {
-            if (par->getcurrtime() - entry.gettimestamp() > par->EN_GPSZ*2+20) {
-                Address x_addr = makeAddress(entry.getid(), entry.getport());
-                log->logNodeRemove(&memberNode->addr, &x_addr);
-                memberNode->memberList.erase(memberNode->memberList.begin() + i);
-                -- i;
-            }
         }
     }
-    // increment heartbeat & add to member list
+    // changes older than gossipHotTicks() are no longer gossiped
+    while (!changeLog.empty() && changeLog.front().first <= par->getcurrtime() - gossipHotTicks()) {
+        changeLog.pop_front();
+    }
+    // increment heartbeat & update my entry
     ++ memberNode->heartbeat;
-    int m_id = *(int*)(&memberNode->addr.addr);
-    short m_port = *(short*)(&memberNode->addr.addr[4]);
-    MemberListEntry m_entry(m_id, m_port, memberNode->heartbeat, par->getcurrtime());
-    memberNode->memberList.push_back(m_entry);
+    MemberListEntry *m_entry = findMember(m_id);
+    if (m_entry == NULL) {
+        MemberListEntry newEntry(m_id, m_port, memberNode->heartbeat, par->getcurrtime());
+        addMember(newEntry);
+        m_entry = findMember(m_id);
+    }
+    m_entry->setheartbeat(memberNode->heartbeat);
+    m_entry->settimestamp(par->getcurrtime());
+    markChanged(m_id);
     // pick a neighbor and send gossip
     sendGossip();
 }
@@ -434,6 +547,10 @@ Address MP1Node::getJoinAddress() {
  */
 void MP1Node::initMemberListTable(Member *memberNode) {
     memberNode->memberList.clear();
+    memberIndex.clear();
+    changeLog.clear();
+    lastChanged.clear();
+    lastGossip.clear();
 }
 
 /**
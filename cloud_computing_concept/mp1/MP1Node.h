@@ -15,6 +15,10 @@
 #include "EmulNet.h"
 #include "Queue.h"
 
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
 /**
  * Macros
  */
@@ -56,6 +60,15 @@ class MP1Node {
     Params *par;
     Member *memberNode;
     char NULLADDR[6];
+    // slot of each member's entry in memberNode->memberList, by node id
+    unordered_map<int, size_t> memberIndex;
+    // (time, id) of every entry put in the gossip deltas, oldest first
+    deque<pair<long, int> > changeLog;
+    // time each entry last went into changeLog, by node id
+    unordered_map<int, long> lastChanged;
+    // time of the last gossip sent to each peer, by node id
+    unordered_map<int, long> lastGossip;
+    long lastFullSync;
 
   public:
     MP1Node(Member *, Params *, EmulNet *, Log *, Address *);
@@ -73,7 +86,14 @@ class MP1Node {
     bool recvCallBack(void *env, char *data, int size);
     void nodeLoopOps();
     Address makeAddress(int id, short port) const;
-    char* serializeMemberList();
+    MemberListEntry* findMember(int id);
+    void addMember(MemberListEntry &entry);
+    void removeMember(size_t slot);
+    void markChanged(int id);
+    long failTimeout() const;
+    long gossipHotTicks() const;
+    vector<MemberListEntry> gossipDelta(int peerId);
+    void sendMemberList(MsgTypes msgType, Address *toAddr, vector<MemberListEntry> &entries);
     vector<MemberListEntry> deserializeMemberList(char *data, size_t size);
     void sendGossip();
     int isNullAddress(Address *addr);
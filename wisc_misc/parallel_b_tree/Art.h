@@ -0,0 +1,79 @@
+#ifndef ART_H
+#define ART_H
+
+#include <iostream>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+class EpochManager;
+class NodePool;
+
+/*
+ * Adaptive radix tree over int keys (Leis et al., "The Adaptive Radix
+ * Tree"), one key byte per level, most significant first, with the sign
+ * bit flipped so byte order is key order. Inner nodes hold 4, 16, 48 or
+ * 256 children and are replaced by the next size up when full; a Node16
+ * is searched with one SSE2 compare. A subtree with a single key is just
+ * its leaf (lazy expansion), and bytes shared by a whole subtree are kept
+ * as the node's prefix, so a lookup touches at most four inner nodes.
+ *
+ * Synchronization is optimistic lock coupling (Leis et al., "The ART of
+ * Practical Synchronization"): each node has a version word with a lock
+ * and an obsolete bit. Readers take no locks; they re-check the versions
+ * of the nodes they read and restart on a change. Writers lock only the
+ * one or two nodes they modify. Replaced nodes and removed leaves are
+ * reclaimed through an EpochManager. Nodes do not shrink, except that a
+ * Node4 left with one leaf is replaced by that leaf.
+ */
+class ArtTree {
+  public:
+    ArtTree();
+    ~ArtTree();
+
+    int  Lookup( int key );
+    void Remove( int key );
+    void Set( int key, int data );
+
+    /* Replaces the contents with entries (ascending, distinct keys); no other operation may run */
+    void Load( const std::vector< std::pair<int,int> > &entries );
+
+    /* Appends pairs with lo <= key <= hi in order, until out holds limit entries; each is current when visited */
+    void Collect( int lo, int hi, std::vector< std::pair<int,int> > &out, size_t limit );
+
+    void print( std::ostream &out );
+
+  private:
+    struct Node;
+    struct Node4;
+    struct Node16;
+    struct Node48;
+    struct Node256;
+    struct Leaf;
+
+    Node * NewNode( int type );
+    Leaf * NewLeaf( int key, int data );
+    static void FreeNode( void * p, void * p_tree );
+    static void FreeLeaf( void * p, void * p_tree );
+    void FreeSubtree( Node * p_node );
+
+    /* Child operations; all but FindChild/Children need the node's write lock */
+    static Node * FindChild( Node * p_node, uint8_t byte );
+    static int    Children( Node * p_node, uint8_t * keys, Node ** children );
+    static bool   IsFull( Node * p_node );
+    static void   AddChild( Node * p_node, uint8_t byte, Node * p_child );
+    static void   ChangeChild( Node * p_node, uint8_t byte, Node * p_child );
+    static void   RemoveChild( Node * p_node, uint8_t byte );
+    Node * Grow( Node * p_node );
+
+    bool CollectNode( Node * p_node, int depth, uint32_t path, uint32_t lo, uint32_t hi,
+                      std::vector< std::pair<int,int> > &out, size_t limit );
+    void print( std::ostream &out, Node * p_node, int indent );
+
+    Node * m_p_root;                 /* A Node256 without prefix; never replaced */
+    EpochManager * m_p_epochs;
+    NodePool * m_p_nodePools[4];     /* One per inner node size */
+    NodePool * m_p_leafPool;
+};
+
+#endif // #ifndef ART_H
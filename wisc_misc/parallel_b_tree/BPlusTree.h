@@ -0,0 +1,52 @@
+#ifndef BPLUSTREE_H
+#define BPLUSTREE_H
+
+#include <iostream>
+#include <utility>
+#include <vector>
+
+/*
+ * A sequential B+-tree mapping int keys to int data. Every node occupies a
+ * fixed number of cache lines, with its keys packed into one contiguous array
+ * so a node can be searched without chasing pointers. All data lives in the
+ * leaves, which are chained left-to-right.
+ *
+ * Not thread-safe: ConcurrentTree wraps it in its tree-wide lock.
+ * Lookups of absent keys return NOT_IN_TREE (see CTree.h).
+ */
+class BPlusTree {
+  public:
+    BPlusTree();
+    ~BPlusTree();
+
+    int  Lookup( int key ) const;
+
+    /* out[i] = Lookup( keys[i] ), with up to MULTI_INFLIGHT descents interleaved */
+    void MultiLookup( const int * keys, int * out, int n ) const;
+    void Remove( int key );
+    void Set( int key, int data );
+
+    /* Replaces the contents with entries (ascending, distinct keys), packing nodes nearly full */
+    void Load( const std::vector< std::pair<int,int> > &entries );
+
+    /* Appends pairs with lo <= key <= hi by walking the leaf chain, until out holds limit entries */
+    void Collect( int lo, int hi, std::vector< std::pair<int,int> > &out, size_t limit ) const;
+
+    void print( std::ostream &out ) const;
+
+  private:
+    struct Node;
+    struct InnerNode;
+    struct LeafNode;
+
+    bool InsertInto( Node * p_node, int key, int data, int &split_key, Node * &p_split );
+    bool RemoveFrom( Node * p_node, int key );
+    void RebalanceChild( InnerNode * p_parent, int index );
+
+    void DeleteSubtree( Node * p_node );
+    void print( std::ostream &out, const Node * p_node, int indent ) const;
+
+    Node * p_root;
+};
+
+#endif // #ifndef BPLUSTREE_H
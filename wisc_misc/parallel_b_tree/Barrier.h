@@ -1,11 +1,22 @@
 #ifndef _BARRIER_H_
 #define _BARRIER_H_
 
+#include "system_specific.h"
+
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 
 /* C++ object-oriented barriers -- use Barrier.C */
-class PThreadLockCVBarrier {
+class ThreadBarrier {
+  public:
+    virtual ~ThreadBarrier() {}
+
+    /* Blocks until all nThreads participants have arrived; reusable back-to-back */
+    virtual void Arrive() = 0;
+};
+
+class PThreadLockCVBarrier : public ThreadBarrier {
   public:
     PThreadLockCVBarrier( int nThreads );
     ~PThreadLockCVBarrier();
@@ -17,6 +28,37 @@ class PThreadLockCVBarrier {
     std::mutex m_l_SyncLock;
     std::condition_variable m_cv_SyncCV;
     int m_nSyncCount;
+    unsigned int m_nGeneration;
+};
+
+/*
+ * Sense-reversing barrier: arrivals decrement a shared counter and the last
+ * one flips the sense word everyone else waits on. Waiters spin for a while
+ * (adapting the spin budget to how long recent phases took) and then sleep
+ * on the sense word with a futex, so a phase change costs a few cache misses
+ * when everyone is close together and no CPU time when they are not.
+ */
+class SpinFutexBarrier : public ThreadBarrier {
+  public:
+    SpinFutexBarrier( int nThreads );
+    ~SpinFutexBarrier();
+
+    void Arrive();
+
+  private:
+    void Sleep( int sense );
+    void WakeAll();
+
+    int m_nThreads;
+    bool m_bOversubscribed;         /* More participants than CPUs: never spin */
+
+    char m_pad0[CACHE_LINE_SIZE];
+    std::atomic<int> m_nRemaining;
+    char m_pad1[CACHE_LINE_SIZE];
+    std::atomic<int> m_nSense;      /* Also the futex word */
+    std::atomic<int> m_nSleepers;
+    std::atomic<int> m_nSpinLimit;
+    char m_pad2[CACHE_LINE_SIZE];
 };
 
 #else // #ifdef __cplusplus
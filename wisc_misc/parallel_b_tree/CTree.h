@@ -1,24 +1,102 @@
 #ifndef CTREE_H
 #define CTREE_H
 
+#include "LockTable.h"
+#include "RedoLog.h"
+#include "RWLock.h"
+
+#include <atomic>
 #include <iostream>
 #include <map>
 #include <mutex>
+#include <stdint.h>
+#include <utility>
+#include <vector>
 
 const int NOT_IN_TREE = -2147483647-1;
 class ConcurrentTree;
+class BPlusTree;
+class SkipList;
+class ArtTree;
+class PartitionedTree;
+class EpochManager;
+class NodePool;
+class TreeSnapshot;
+
+/* <key,data> pairs in ascending key order, as produced by range scans */
+typedef std::vector< std::pair<int,int> > TreeEntries;
+
+/* Receives each <key,data> pair of a scan, in ascending key order */
+typedef void (*ScanCallback)( int key, int data, void * p_arg );
+
+/* Index structure that stores the map */
+enum TreeEngine {
+    ENGINE_BINARY_TREE, /* unbalanced binary tree of ConcurrentTreeNodes */
+    ENGINE_BPLUS_TREE,  /* cache-line sized B+-tree nodes (BPlusTree.h) */
+    ENGINE_SKIP_LIST,   /* lock-free skip list (SkipList.h); synchronizes itself, whatever the SyncMode */
+    ENGINE_ART          /* adaptive radix tree (Art.h), optimistic lock coupling; ignores the SyncMode too */
+};
+
+/* How the atomic Lookup/Set/Remove operations synchronize on the tree */
+enum SyncMode {
+    SYNC_GLOBAL_LOCK,     /* one tree-wide reader/writer lock */
+    SYNC_LOCK_COUPLING,   /* per-node locks, acquired hand-over-hand on the way down */
+    SYNC_LOCK_FREE_READS, /* writers couple locks, Lookup takes none; nodes reclaimed by epoch */
+    SYNC_FLAT_COMBINING   /* tree-wide lock; one writer applies everyone's pending Set/Remove */
+};
+
+/* How the transactional interface keeps transactions serializable */
+enum TxnMode {
+    TXN_GLOBAL_LOCK, /* one transaction at a time */
+    TXN_OCC,         /* optimistic: versioned keys, buffered writes, validation at commit */
+    TXN_TWO_PHASE_LOCKING /* strict 2PL on per-key locks (LockTable.h), wait-die, buffered writes */
+};
+
+/* Construction-time options for ConcurrentTree */
+struct TreeConfig {
+    TreeConfig() : engine( ENGINE_BINARY_TREE ), sync( SYNC_GLOBAL_LOCK ), txn( TXN_GLOBAL_LOCK ),
+                   rwlock( RWLOCK_COUNTING ), partitions( 0 ), partition_keys( 0 ), partition_delegate( false ) {}
+
+    TreeEngine   engine;
+    SyncMode     sync;   /* Per-node locking (coupling, lockfree) requires ENGINE_BINARY_TREE */
+    TxnMode      txn;
+    RWLockPolicy rwlock; /* Only used with the tree-wide lock (global, combining) */
+
+    /* Non-zero: the map is split into this many per-socket shards (Partition.h) */
+    int  partitions;
+    int  partition_keys;     /* Key space [0,partition_keys) cut evenly between the shards */
+    bool partition_delegate; /* Delegate even operations on the caller's own socket, to measure the queues */
+};
+
+/*
+ * Number of versioned locks used by TXN_OCC. Key k is covered by entry
+ * k & (TXN_STRIPES-1), so a dense key range maps onto distinct entries.
+ */
+const int TXN_STRIPES = 1 << 16;
+
+/* Descents kept in flight by the batched operations */
+const int MULTI_INFLIGHT = 16;
+
+/* Publication slots of SYNC_FLAT_COMBINING; more writers than this share slots */
+const int COMBINE_SLOTS = 64;
 
 class ConcurrentTreeNode {
   public:
     ConcurrentTreeNode();
-    ~ConcurrentTreeNode();
+
+    /* Nodes live in a NodePool; Destroy() does not touch the children */
+    static ConcurrentTreeNode * Create( NodePool * p_pool, int key, int data );
+    static void Destroy( NodePool * p_pool, ConcurrentTreeNode * p_node );
 
     int  Lookup( int key );
-    void Remove( int key );
-    void Set( int key, int data );
+    void Remove( NodePool * p_pool, int key );
+    void Set( NodePool * p_pool, int key, int data );
 
     void print( std::ostream &out, int indent );
 
+    /* Appends pairs with lo <= key <= hi in order, until out holds limit entries */
+    void Collect( int lo, int hi, TreeEntries &out, size_t limit );
+
     /* To facilitate deletion */
     ConcurrentTreeNode* MaxKey();
 
@@ -29,12 +107,14 @@ class ConcurrentTreeNode {
     int m_key, m_data;
 
     /* Add any data members you want here */
+    std::mutex m_l_nodeLock; /* Only used with per-node locking */
+    bool m_bRemoved;         /* Set before unlinking, for lock-free readers still passing by */
 
 };
 
 class ConcurrentTree {
   public:
-    ConcurrentTree( int max_threads );
+    ConcurrentTree( int max_threads, const TreeConfig &config = TreeConfig() );
     ~ConcurrentTree();
 
     int  Lookup( int key );
@@ -43,15 +123,131 @@ class ConcurrentTree {
 
     void print( std::ostream &out );
 
+    /*
+     * Calls callback for every pair with lo <= key <= hi, in key order. The
+     * pairs are a consistent snapshot: they are gathered in one pass while
+     * writers are held off, and callbacks run after the tree is released.
+     * ENGINE_SKIP_LIST and ENGINE_ART never hold writers off: each pair is
+     * current when visited, and pairs not written during the scan are all
+     * reported. A partitioned tree takes its shards one after the other, so
+     * the snapshot only holds shard by shard; TransactionalScan is atomic.
+     */
+    void Scan( int lo, int hi, ScanCallback callback, void * p_arg );
+
+    /*
+     * Batched operations on n keys. Under SYNC_GLOBAL_LOCK the lock is taken
+     * once for the whole batch, and up to MULTI_INFLIGHT descents advance in
+     * turn, each prefetching its next node, so their cache misses overlap.
+     * MultiLookup sets out[i] to the data of keys[i] (or NOT_IN_TREE).
+     * MultiSet applies the pairs in order: a repeated key keeps its last
+     * data. With per-node locking every key is a separate atomic operation.
+     */
+    void MultiLookup( const int * keys, int * out, int n );
+    void MultiSet( const int * keys, const int * data, int n );
+
+    /*
+     * Loads n pairs at once and leaves a perfectly balanced tree (B+-tree:
+     * nodes packed nearly full). Input may be in any order; it is sorted
+     * unless already ascending, and a repeated key keeps its last data.
+     * Pairs already in the tree are kept unless the input sets them. The
+     * sort and the build are split over nThreads threads. Takes no locks:
+     * like the constructor, it must not overlap any other operation.
+     */
+    void BulkLoad( const int * keys, const int * data, int n, int nThreads = 1 );
+
+    /*
+     * SaveSnapshot writes every pair to path in the layout of Snapshot.h;
+     * false if the file cannot be written. OpenSnapshot maps such a file
+     * as a read-only base under the tree (warm restart): lookups that miss
+     * the tree fall through to it, Remove hides its pairs, and Set shadows
+     * them, so nothing is loaded up front and pages fault in as keys are
+     * touched. Returns false if path is not a snapshot. Like BulkLoad it
+     * must not overlap any other operation. Scans see a base pair only if
+     * it is current when read; it is not part of their point-in-time view.
+     */
+    bool SaveSnapshot( const char * path );
+    bool OpenSnapshot( const char * path );
+
+    /*
+     * Replays the redo log at path (RedoLog.h) into the tree, then logs
+     * every transaction that commits with writes, so OpenLog on a fresh
+     * tree after a crash brings back each commit that was durable. The
+     * record is queued while the transaction still holds its locks or
+     * stripes, and the commit waits for it per durability after letting
+     * go of them. A read-only commit waits for everything queued before
+     * it, so nothing it saw can be lost. Atomic Set/Remove are not logged.
+     * Returns false if path cannot be opened. Like BulkLoad it must not
+     * overlap any other operation.
+     */
+    bool OpenLog( const char * path, LogDurability durability = LOG_GROUP_COMMIT, int group_usecs = 0 );
+    RedoLog * GetLog() const { return m_p_log; }   /* NULL unless OpenLog succeeded */
+
+    const TreeConfig &GetConfig() const { return m_config; }
+
+    /*
+     * Transactional accessors return true if the transaction must abort. So
+     * does CommitTransaction(), in which case none of the transaction's
+     * writes were applied. Either way the caller then calls
+     * TransactionAborted() and starts over with InitiateTransaction().
+     */
     void InitiateTransaction();
-    void CommitTransaction();
+    bool CommitTransaction();
     void TransactionAborted();
 
     bool TransactionalLookup( int &data, int key );
     bool TransactionalRemove( int key );
     bool TransactionalSet( int key, int data );
 
+    /*
+     * Scan as part of the current transaction; sees the transaction's own
+     * writes. Under TXN_OCC writers are never held off for the whole pass:
+     * consistency is checked against the stripe versions instead, and a
+     * conflicting commit makes this return true (abort). Under
+     * TXN_TWO_PHASE_LOCKING it locks the whole table shared until commit.
+     */
+    bool TransactionalScan( int lo, int hi, ScanCallback callback, void * p_arg );
+
   private:
+    friend class PartitionedTree;
+
+    bool UsesTreeLock() const { return m_config.sync == SYNC_GLOBAL_LOCK || m_config.sync == SYNC_FLAT_COMBINING; }
+    bool UsesNodeLocks() const { return !UsesTreeLock(); }
+
+    /* Set/Remove under the tree-wide write lock, which the caller holds */
+    void LockedSet( int key, int data );
+    void LockedRemove( int key );
+
+    /* SYNC_FLAT_COMBINING: publishes one Set/Remove and returns once some combiner has applied it */
+    void CombinedWrite( int key, int data, bool remove );
+    void Combine();
+
+    /* SYNC_LOCK_COUPLING implementations of the atomic operations; also the writers of SYNC_LOCK_FREE_READS */
+    int  CoupledLookup( int key );
+    void CoupledRemove( int key );
+    void CoupledSet( int key, int data );
+    void CoupledCollect( int lo, int hi, TreeEntries &out, size_t limit, bool snapshot );
+    void DisposeNode( ConcurrentTreeNode * p_node );
+    static void FreeRetiredNode( void * p, void * p_pool );
+
+    /* Interleaved batch descents over the binary tree; the caller holds the tree lock */
+    void InterleavedLookup( const int * keys, int * out, int n );
+    void InterleavedSet( const int * keys, const int * data, int n );
+
+    /* BulkLoad helpers */
+    ConcurrentTreeNode * BuildBalanced( const TreeEntries &entries, size_t lo, size_t hi, int nThreads );
+    void DestroyAll();
+
+    /* Lookup in the tree proper, without the snapshot base */
+    int  TreeLookup( int key );
+
+    /* SYNC_LOCK_FREE_READS lookup, inside an epoch */
+    int  LockFreeLookup( int key );
+
+    /* Gathers pairs in [lo,hi] under the engine's synchronization */
+    void CollectRange( int lo, int hi, TreeEntries &out, size_t limit, bool snapshot );
+    void CollectTreeRange( int lo, int hi, TreeEntries &out, size_t limit, bool snapshot ); /* Ignoring m_p_base */
+    void CollectOverBase( int lo, int hi, TreeEntries &out, size_t limit, bool snapshot );
+    void CollectRangeInChunks( int lo, int hi, TreeEntries &out );
 
     void AcquireReadLock();
     void ReleaseReadLock();
@@ -62,16 +258,81 @@ class ConcurrentTree {
     void AcquireTransactionalLock();
     void ReleaseTransactionalLock();
 
+    /* TXN_OCC implementation of the transactional interface */
+    bool OptimisticLookup( int &data, int key );
+    bool OptimisticScan( int lo, int hi, ScanCallback callback, void * p_arg );
+    bool OptimisticCommit();
+    bool RangeIsCurrent( int lo, int hi );
+
+    /* TXN_TWO_PHASE_LOCKING implementation; each returns true if the transaction must die */
+    bool LockKey( int key, LockMode mode );
+    bool LockTableIn( LockMode mode );
+    bool LockingLookup( int &data, int key );
+    bool LockingWrite( int key, int data );
+    bool LockingScan( int lo, int hi, ScanCallback callback, void * p_arg );
+    void LockingCommit();
+    void ReleaseKeyLocks();
+
+    /* Queues a committing transaction's writes (if any); returns the LSN AwaitLog must wait for */
+    uint64_t LogCommit( const std::map<int,int> &writes );
+    void AwaitLog( uint64_t lsn );
+
     ConcurrentTreeNode * p_root;
 
     /* Add any data members you want here */
-    std::mutex m_l_writeLock;
-    int m_nReadLocks;
-    int m_nWritesRequested;
+    RWLock * m_p_treeLock;           /* Non-NULL iff UsesTreeLock() */
+
+    /*
+     * SYNC_FLAT_COMBINING publication list. A writer claims a free slot,
+     * fills in its request and marks it pending, then spins on its own
+     * slot. Whoever wins m_bCombining takes the write lock once, applies
+     * every pending request and marks each one done, so the lock and the
+     * tree's hot nodes stay in one cache while a batch is applied.
+     */
+    struct CombineSlot {
+        std::atomic<int> state;
+        int key, data;
+        bool remove;
+        char m_pad[CACHE_LINE_SIZE - sizeof( std::atomic<int> ) - 2 * sizeof( int ) - sizeof( bool )];
+    };
+    CombineSlot * m_p_combineSlots;
+    std::atomic<int> m_nCombineSlotsUsed;  /* Slots at or above this were never claimed */
+    std::atomic<bool> m_bCombining;
+    char m_pad[CACHE_LINE_SIZE];
 
     int m_nNextThreadID, m_nThreads;
     std::mutex m_l_transLock;
 
+    /*
+     * TXN_OCC state: a global version clock and one versioned lock per
+     * stripe, holding (version << 1) | locked.
+     */
+    std::atomic<uint64_t> m_nVersionClock;
+    std::atomic<uint64_t> * m_p_stripeVersions;
+
+    LockTable * m_p_lockTable;       /* Non-NULL iff m_config.txn == TXN_TWO_PHASE_LOCKING */
+
+    TreeConfig m_config;
+    std::mutex m_l_rootLock; /* Guards p_root when using per-node locks */
+
+    /*
+     * SYNC_LOCK_FREE_READS: removed nodes go through m_p_epochs. Removing a
+     * node with two children moves a key up the tree, which a reader
+     * already below could miss; those removals are counted, so a reader
+     * that did not find its key can tell whether to look again.
+     */
+    EpochManager * m_p_epochs;
+    std::atomic<uint64_t> m_nRestructuresBegun;
+    std::atomic<uint64_t> m_nRestructuresDone;
+
+    BPlusTree * m_p_bplus;   /* Non-NULL iff m_config.engine == ENGINE_BPLUS_TREE */
+    SkipList * m_p_skip;     /* Non-NULL iff m_config.engine == ENGINE_SKIP_LIST */
+    ArtTree * m_p_art;       /* Non-NULL iff m_config.engine == ENGINE_ART */
+    NodePool * m_p_nodePool; /* Non-NULL iff m_config.engine == ENGINE_BINARY_TREE */
+    PartitionedTree * m_p_parts; /* Non-NULL iff m_config.partitions > 0; then none of the above are */
+    TreeSnapshot * m_p_base; /* Set by OpenSnapshot; pairs not shadowed by the tree */
+    RedoLog * m_p_log;       /* Set by OpenLog */
+
 };
 
 #endif // #ifndef CTREE_H
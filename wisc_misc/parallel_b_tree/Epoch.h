@@ -0,0 +1,57 @@
+#ifndef EPOCH_H
+#define EPOCH_H
+
+#include "system_specific.h"
+#include "ThreadSlots.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Epoch-based reclamation. Threads that read shared nodes without locks
+ * bracket each traversal with Enter()/Exit(). A node that has been unlinked
+ * is handed to Retire() rather than freed; it is freed once the global epoch
+ * has advanced twice past the epoch it was retired in, which can only happen
+ * after every traversal that might still see it has exited.
+ *
+ * Retired nodes are kept in per-thread batches and freed EPOCH_BATCH at a
+ * time. Writers that never traverse without locks need not Enter().
+ */
+const int EPOCH_MAX_THREADS = 256;
+const int EPOCH_BATCH       = 64;
+
+class EpochManager {
+  public:
+    EpochManager();
+    ~EpochManager();  /* Frees everything still retired; no thread may be inside */
+
+    void Enter();
+    void Exit();
+
+    /* p is freed with free_fn( p, p_arg ) once no traversal can reach it anymore */
+    void Retire( void * p, void (*free_fn)( void * p, void * p_arg ), void * p_arg );
+
+  private:
+    struct Retired {
+        void * p;
+        void (*free_fn)( void * p, void * p_arg );
+        void * p_arg;
+        uint64_t epoch;
+    };
+
+    struct ThreadSlot {
+        std::atomic<uint64_t> active_epoch;  /* 0 when outside Enter()/Exit() */
+        std::vector<Retired>  limbo;         /* Touched by the owner only */
+    };
+
+    bool TryAdvance();
+    void FreeExpired( ThreadSlot * p_slot );
+
+    char m_pad0[CACHE_LINE_SIZE];
+    std::atomic<uint64_t> m_nEpoch;
+    char m_pad1[CACHE_LINE_SIZE];
+    ThreadSlots<ThreadSlot> m_slots;
+};
+
+#endif // #ifndef EPOCH_H
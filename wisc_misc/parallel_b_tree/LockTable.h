@@ -0,0 +1,80 @@
+#ifndef LOCKTABLE_H
+#define LOCKTABLE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+/* Modes of a LockTable lock; a holder asking for a mode it does not cover is upgraded to LOCK_EXCLUSIVE */
+enum LockMode {
+    LOCK_SHARED,            /* compatible with other LOCK_SHARED holders */
+    LOCK_INTENT_EXCLUSIVE,  /* compatible with other LOCK_INTENT_EXCLUSIVE holders */
+    LOCK_EXCLUSIVE          /* compatible with nothing */
+};
+
+/*
+ * Per-key locks for strict two-phase locking (TXN_TWO_PHASE_LOCKING).
+ * Keys hash onto LOCKTABLE_BUCKETS buckets; each bucket has a mutex, a
+ * condition variable and the entries of its keys that are held or waited
+ * for, so only transactions touching the same bucket meet on a mutex and
+ * only those touching the same key wait for each other.
+ *
+ * Deadlock is avoided by wait-die: every transaction carries a timestamp
+ * from NextTimestamp(), and a request that conflicts with a holder waits
+ * only if it is older than every conflicting holder. Otherwise Acquire()
+ * returns false and the requester must abort, keeping its timestamp so it
+ * eventually becomes the oldest. Waits only ever go from older to younger
+ * transactions, so they cannot form a cycle. A new request may not jump an
+ * older waiter it conflicts with either, so a waiting scan is not starved
+ * by a stream of compatible writers.
+ *
+ * Besides the keys there is a single table lock: scans take it shared to
+ * keep out phantoms, writers take it intent-exclusive.
+ */
+const int LOCKTABLE_BUCKETS = 1 << 12;
+
+class LockTable {
+  public:
+    LockTable();
+    ~LockTable();
+
+    uint64_t NextTimestamp() { return m_nClock.fetch_add( 1 ) + 1; }
+
+    /* Grants key in mode to transaction ts, or returns false if ts must die */
+    bool Acquire( int key, LockMode mode, uint64_t ts );
+    void Release( int key, uint64_t ts );
+
+    bool AcquireTable( LockMode mode, uint64_t ts );
+    void ReleaseTable( uint64_t ts );
+
+  private:
+    struct Holder {
+        uint64_t ts;
+        LockMode mode;
+    };
+
+    struct Entry {
+        int key;
+        std::vector<Holder> holders;
+        std::vector<Holder> waiters;
+    };
+
+    struct Bucket {
+        std::mutex lock;
+        std::condition_variable released;
+        std::vector<Entry> entries;
+    };
+
+    bool Acquire( Bucket * p_bucket, int key, LockMode mode, uint64_t ts );
+    void Release( Bucket * p_bucket, int key, uint64_t ts );
+    static size_t Find( Bucket * p_bucket, int key );
+    static void Forget( std::vector<Holder> &list, uint64_t ts );
+
+    Bucket * m_p_buckets;
+    Bucket m_tableBucket;        /* Holds the table lock as its only entry */
+    std::atomic<uint64_t> m_nClock;
+};
+
+#endif // #ifndef LOCKTABLE_H
@@ -0,0 +1,62 @@
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include "system_specific.h"
+#include "ThreadSlots.h"
+
+#include <atomic>
+#include <mutex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/*
+ * Fixed-size block allocator for tree nodes. Each thread carves blocks out
+ * of its own slabs and recycles freed blocks through a private free list,
+ * so the common case touches no shared state, and nodes inserted together
+ * by one thread end up next to each other. Blocks are cache-line aligned.
+ * A slab is first written by the thread that carves it, so first-touch
+ * page placement puts it on that thread's NUMA node.
+ *
+ * A thread that accumulates POOL_LOCAL_LIMIT free blocks hands half of
+ * them to a shared depot for others to reuse. Destroying the pool releases
+ * every slab at once; it does not run destructors, so the owner destructs
+ * its live objects first.
+ */
+const int    POOL_MAX_THREADS = 256;
+const size_t POOL_SLAB_BYTES  = 64 * 1024;
+const int    POOL_LOCAL_LIMIT = 1024;
+
+class NodePool {
+  public:
+    NodePool( size_t block_bytes );
+    ~NodePool();
+
+    void * Allocate();
+    void   Free( void * p );
+
+  private:
+    struct FreeBlock {
+        FreeBlock * p_next;
+    };
+
+    struct ThreadCache {
+        FreeBlock * p_free;
+        int nFree;
+        char * p_bump;                 /* Uncarved remainder of the current slab */
+        char * p_end;
+    };
+
+    void Refill( ThreadCache * p_cache );
+
+    size_t m_nBlockBytes;
+
+    std::mutex m_l_poolLock;           /* Guards m_slabs and m_depot */
+    std::vector<void*> m_slabs;
+    std::vector<FreeBlock*> m_depot;   /* Lists of POOL_LOCAL_LIMIT/2 blocks */
+    std::atomic<int> m_nDepotLists;
+
+    ThreadSlots<ThreadCache> m_caches;
+};
+
+#endif // #ifndef NODEPOOL_H
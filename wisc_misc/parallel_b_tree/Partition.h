@@ -0,0 +1,137 @@
+#ifndef PARTITION_H
+#define PARTITION_H
+
+#include "system_specific.h"
+#include "CTree.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+class ProcessorMap;
+
+/* Requests a delegation queue holds; producers spin while it is full */
+const int DELEGATE_QUEUE_SIZE = 256;
+
+/* Polls of an empty queue before an owner parks, and of a pending request before its caller blocks */
+const int DELEGATE_SPINS = 2048;
+
+/* One operation handed to a shard's owner; lives on the caller's stack until done */
+struct ShardRequest {
+    int op;                       /* DELEGATE_* in Partition.C */
+    int key, data, hi;
+    size_t limit;
+    bool snapshot;
+    TreeEntries * p_out;          /* Collect: pairs are appended here */
+    const TreeEntries * p_load;   /* Load: sorted pairs of this shard */
+    std::ostream * p_stream;      /* Print */
+    int result;                   /* Lookup */
+    std::atomic<bool> done;       /* Set by the owner once the request is complete */
+};
+
+/*
+ * Bounded multi-producer, single-consumer queue of request pointers
+ * (Vyukov). Each cell carries a sequence number telling producers and the
+ * consumer whose turn it is, so neither side ever takes a lock.
+ */
+class DelegationQueue {
+  public:
+    DelegationQueue();
+
+    bool Push( ShardRequest * p_request );  /* false if full */
+    ShardRequest * Pop();                   /* NULL if empty; owner thread only */
+
+  private:
+    struct Cell {
+        std::atomic<uint64_t> sequence;
+        ShardRequest * p_request;
+    };
+
+    Cell m_cells[DELEGATE_QUEUE_SIZE];
+    char m_pad0[CACHE_LINE_SIZE];
+    std::atomic<uint64_t> m_nTail;          /* Next position a producer claims */
+    char m_pad1[CACHE_LINE_SIZE];
+    uint64_t m_nHead;                       /* Next position the owner reads */
+    char m_pad2[CACHE_LINE_SIZE];
+};
+
+/*
+ * Key-range partitioned map behind ConcurrentTree (TreeConfig::partitions).
+ * [0,partition_keys) is cut into equal ranges, one per shard; keys below
+ * the space go to the first shard and keys above it to the last. Shard i
+ * belongs to socket i % NumberOfSockets() and is owned by a thread bound
+ * to one of that socket's processors, which allocates the shard's tree
+ * and queue so they are placed on the socket's memory.
+ *
+ * A caller running on the shard's socket operates on the shard's tree
+ * directly; anyone else pushes a request into the shard's queue and waits
+ * until the owner has applied it, so a shard's nodes only ever travel
+ * between caches of one socket. Owners and callers poll for a while before
+ * blocking, unless workers and owners together outnumber the processors:
+ * then polling only delays the thread being waited for. Each shard is a complete
+ * ConcurrentTree with the configured engine and synchronization.
+ *
+ * Operations are atomic per key. Atomicity across shards is left to the
+ * transaction layer above, which works on keys whatever shard they are in.
+ */
+class PartitionedTree {
+  public:
+    PartitionedTree( int max_threads, const TreeConfig &config );
+    ~PartitionedTree();   /* Stops the owners; no other operation may run */
+
+    int  Lookup( int key );
+    void Remove( int key );
+    void Set( int key, int data );
+
+    /* Each shard's pairs are gathered as by ConcurrentTree::CollectRange; shards one after the other */
+    void Collect( int lo, int hi, TreeEntries &out, size_t limit, bool snapshot );
+
+    /* Sorted, distinct pairs; every shard loads its part in parallel */
+    void Load( const TreeEntries &entries );
+
+    void print( std::ostream &out );
+
+  private:
+    struct Shard {
+        ConcurrentTree * p_tree;
+        DelegationQueue queue;
+        std::atomic<bool> m_bParked;        /* Owner is waiting on m_wakeup */
+        std::mutex m_l_park;
+        std::condition_variable m_wakeup;
+
+        std::atomic<int> m_nBlocked;        /* Callers waiting on m_completed */
+        std::mutex m_l_completed;
+        std::condition_variable m_completed;
+    };
+
+    int  ShardOf( int key ) const;
+    int  LowerBound( int shard ) const;
+    int  UpperBound( int shard ) const;
+    bool IsLocal( int shard ) const;
+
+    /* Owner side: body of shard's thread, and one request */
+    void Own( int shard, int pproc, int max_threads, TreeConfig config );
+    void Execute( Shard * p_shard, ShardRequest * p_request );
+    static void Complete( Shard * p_shard, ShardRequest * p_request );
+
+    /* Caller side: Post() hands p_request to the owner, Await() waits until it is done */
+    void Post( int shard, ShardRequest * p_request );
+    void Await( int shard, ShardRequest * p_request );
+    void Delegate( int shard, ShardRequest * p_request );
+
+    int m_nShards;
+    int m_nWidth;                           /* Keys per shard */
+    bool m_bDelegateAll;
+    bool m_bOversubscribed;                 /* Workers and owners outnumber the processors: never poll */
+    int m_nSockets;
+    ProcessorMap * m_p_map;
+    int * m_p_sockets;                      /* Socket of each shard */
+    std::atomic<Shard *> * m_p_shards;      /* Published by the owners once they are ready */
+    std::vector<std::thread *> m_owners;
+};
+
+#endif // #ifndef PARTITION_H
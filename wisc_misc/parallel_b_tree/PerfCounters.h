@@ -0,0 +1,50 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <stdint.h>
+
+/* Events counted by PerfCounters, in the order of ThreadStats::perf */
+enum PerfEvent {
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_LLC_MISSES,
+    PERF_DTLB_MISSES,
+    PERF_CONTEXT_SWITCHES
+};
+const int PERF_EVENTS = 5;
+
+/*
+ * Per-thread hardware and software counters (Linux perf_event_open). Each
+ * event is opened for the calling thread on its own, so one the kernel or
+ * a VM does not offer leaves the others working. Where the paranoia level
+ * forbids counting kernel mode, an event falls back to user mode only.
+ * Counts are scaled up for time lost to multiplexing. Elsewhere, or when
+ * nothing can be opened, the counters simply report nothing.
+ */
+class PerfCounters {
+  public:
+    PerfCounters();   /* Opens the calling thread's counters, stopped */
+    ~PerfCounters();
+
+    void Start();     /* Notes where every open counter stands and enables it */
+
+    /* Stops counting; adds each open event's count to counts[e] and sets bit e of *p_opened */
+    void Stop( uint64_t * counts, uint32_t * p_opened );
+
+  private:
+    int m_fds[PERF_EVENTS];   /* -1 where the event could not be opened */
+
+    /*
+     * Value, time enabled and time running at Start(). Resetting a counter
+     * zeroes only its value, never the times, so Stop() scales the deltas.
+     */
+    uint64_t m_start[PERF_EVENTS][3];
+};
+
+/* Name of the event, for reports */
+const char * perfEventName( int event );
+
+/* Why the first event that could not be opened failed, or NULL if all opened so far */
+const char * perfUnavailableReason();
+
+#endif // #ifndef PERFCOUNTERS_H
@@ -1,26 +1,75 @@
 #ifndef PROCMAP_H
 #define PROCMAP_H
 
+/*
+ * Order in which logical processors 0,1,2,... are handed out. Thread i is
+ * bound to LogicalToPhysical( i ), so the policy decides which hardware a
+ * run with fewer threads than processors lands on.
+ */
+enum PlacementPolicy {
+    PLACE_MASK_ORDER,   /* ascending processor number within the affinity mask, ignoring the topology */
+    PLACE_COMPACT,      /* SMT siblings of a core, then the next core, then the next socket */
+    PLACE_SCATTER,      /* round-robin over sockets, then over cores; SMT siblings last */
+    PLACE_ONE_PER_CORE, /* one hardware thread per core, socket by socket */
+    PLACE_SOCKET_LOCAL  /* only the processors of one socket, compactly */
+};
+
 class ProcessorMap {
   public:
-    ProcessorMap();
+    /* socket only matters for PLACE_SOCKET_LOCAL */
+    ProcessorMap( PlacementPolicy policy = PLACE_MASK_ORDER, int socket = 0 );
     ~ProcessorMap();
 
     int LogicalToPhysical(int lproc) const;
     int PhysicalToLogical(int pproc) const;
-    int NumberOfProcessors() const { return m_nProcs; }
+    int NumberOfProcessors() const { return m_nProcs; }  /* Usable under the policy */
 
     int operator[]( int index ) const { return LogicalToPhysical( index ); }
 
     void BindToPhysicalCPU( int pproc ) const;
 
+    /*
+     * Topology of every processor in the affinity mask. Socket ids are
+     * dense, 0..NumberOfSockets()-1, so they can index per-socket arrays.
+     * Without topology information (Solaris, or no /sys) every processor
+     * is its own core on socket 0.
+     */
+    int SocketOf( int pproc ) const;
+    int CoreOf( int pproc ) const;      /* Dense over all sockets */
+    int NumberOfSockets() const { return m_nSockets; }
+    int NumberOfCores() const   { return m_nCores; }
+
+    /* Socket of the processor the caller is running on right now */
+    int CurrentSocket() const;
+
+    PlacementPolicy Policy() const { return m_policy; }
+
   private:
+    struct CPUInfo {
+        int id;
+        int socket;
+        int core;
+        int sibling;  /* Rank among the SMT siblings of its core */
+    };
+
     void IntegrityCheck() const;
     int DetermineNumberOfProcessors();
+    void DetermineTopology();
+    void ApplyPolicy( int socket );
+    const CPUInfo * Find( int pproc ) const;
 
     int * m_p_nProcessor_Ids;
     int m_nProcs;
 
+    CPUInfo * m_p_cpus;     /* Every processor in the affinity mask, ascending id */
+    int m_nAvailable;
+    int m_nSockets, m_nCores;
+    PlacementPolicy m_policy;
+
 };
 
+/* Parses mask, compact, scatter, core or socket[:N]; returns false if arg is none of them */
+bool parsePlacement( const char * arg, PlacementPolicy &policy, int &socket );
+const char * placementName( PlacementPolicy policy );
+
 #endif // #ifndef PROCMAP_H
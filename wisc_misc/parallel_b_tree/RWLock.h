@@ -0,0 +1,144 @@
+#ifndef RWLOCK_H
+#define RWLOCK_H
+
+#include "system_specific.h"
+
+#include <atomic>
+#include <mutex>
+#include <stdint.h>
+
+/* Selects one of the implementations below */
+enum RWLockPolicy {
+    RWLOCK_COUNTING,    /* reader count behind a mutex */
+    RWLOCK_DISTRIBUTED, /* per-thread reader slots, writer-preferring */
+    RWLOCK_TICKET,      /* FIFO ticket lock, fair to readers and writers */
+    RWLOCK_SPIN_PARK    /* writer-preferring, spins and then sleeps on a futex */
+};
+
+/*
+ * Reader/writer locks guarding a whole tree (SYNC_GLOBAL_LOCK). The tree
+ * picks an implementation from TreeConfig::rwlock; all of them are
+ * non-recursive, and a thread holds at most one of them at a time.
+ */
+class RWLock {
+  public:
+    virtual ~RWLock() {}
+
+    static RWLock * Create( RWLockPolicy policy );
+
+    virtual void ReadLock() = 0;
+    virtual void ReadUnlock() = 0;
+    virtual void WriteLock() = 0;
+    virtual void WriteUnlock() = 0;
+};
+
+/*
+ * The original lock: a reader count guarded by a mutex. Readers hold off
+ * while writers are waiting. Every acquire and release goes through the
+ * mutex's cache line.
+ */
+class CountingRWLock : public RWLock {
+  public:
+    CountingRWLock();
+
+    void ReadLock();
+    void ReadUnlock();
+    void WriteLock();
+    void WriteUnlock();
+
+  private:
+    std::mutex m_l_writeLock;
+    volatile int m_nReadLocks;       /* volatile: both are spun on outside the lock */
+    volatile int m_nWritesRequested;
+};
+
+/*
+ * Distributed reader indicator: each thread announces itself in one of
+ * RWLOCK_READER_SLOTS padded counters, so readers on different CPUs never
+ * write the same line. A writer raises its flag and then waits for every
+ * slot to drain; readers that see the flag back out, which makes the lock
+ * writer-preferring. Threads take slots round-robin on first use, which
+ * with one thread per CPU gives each CPU its own slot.
+ */
+const int RWLOCK_READER_SLOTS = 64;
+
+class DistributedRWLock : public RWLock {
+  public:
+    DistributedRWLock();
+    ~DistributedRWLock();
+
+    void ReadLock();
+    void ReadUnlock();
+    void WriteLock();
+    void WriteUnlock();
+
+  private:
+    struct ReaderSlot {
+        std::atomic<int> readers;
+        char m_pad[CACHE_LINE_SIZE - sizeof( std::atomic<int> )];
+    };
+
+    ReaderSlot * m_p_slots;
+    std::atomic<bool> m_bWriter;
+    char m_pad[CACHE_LINE_SIZE];
+};
+
+/*
+ * Fair (FIFO) reader/writer ticket lock. Everyone draws a ticket from
+ * m_nNext. A reader enters once every earlier ticket has entered, so
+ * consecutive readers share the lock; a writer enters once every earlier
+ * ticket has left. Neither side can starve. Waiters back off in
+ * proportion to their distance from the head of the queue.
+ */
+class TicketRWLock : public RWLock {
+  public:
+    TicketRWLock();
+
+    void ReadLock();
+    void ReadUnlock();
+    void WriteLock();
+    void WriteUnlock();
+
+  private:
+    std::atomic<uint32_t> m_nNext;
+    char m_pad0[CACHE_LINE_SIZE];
+    std::atomic<uint32_t> m_nEntered;  /* Tickets let in: readers on entry, writers on exit */
+    std::atomic<uint32_t> m_nLeft;     /* Tickets done */
+    char m_pad1[CACHE_LINE_SIZE];
+};
+
+/*
+ * Writer-preferring lock in one word (reader count and writer bit).
+ * Readers stay out while any writer waits. Blocked threads spin for
+ * RWLOCK_SPIN_LIMIT rounds and then park on a futex, so long critical
+ * sections and oversubscribed runs do not burn CPU.
+ */
+const int RWLOCK_SPIN_LIMIT = 1024;
+
+class SpinParkRWLock : public RWLock {
+  public:
+    SpinParkRWLock();
+
+    void ReadLock();
+    void ReadUnlock();
+    void WriteLock();
+    void WriteUnlock();
+
+  private:
+    static const int WRITER = 1;
+    static const int READER = 2;
+
+    bool ReaderMustWait() const;
+    bool WriterMustWait() const;
+    void Park( bool writer );
+    void WakeAll();
+
+    std::atomic<int> m_nState;
+    std::atomic<int> m_nWritersWaiting;
+    char m_pad0[CACHE_LINE_SIZE];
+    std::atomic<int> m_nWakeups;       /* Futex word; bumped on every release that may unblock */
+    std::atomic<int> m_nSleepers;
+    char m_pad1[CACHE_LINE_SIZE];
+};
+
+#endif // #ifndef RWLOCK_H
@@ -0,0 +1,79 @@
+#ifndef REDOLOG_H
+#define REDOLOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+class ConcurrentTree;
+
+/* When CommitTransaction() returns, relative to its log record reaching the disk */
+enum LogDurability {
+    LOG_GROUP_COMMIT, /* after: one fdatasync covers every commit queued while the previous one ran */
+    LOG_ASYNC_COMMIT  /* before: the record is queued and synced in the background; a crash loses the last batches */
+};
+
+/* The writer stops lingering for more commits once a batch holds this many bytes */
+const size_t LOG_GROUP_BYTES = 1 << 20;
+
+/*
+ * Redo log of committed transactions. Committing threads append their
+ * write set to an in-memory buffer; a dedicated writer thread swaps the
+ * buffer out, writes it with one write() and makes it durable with one
+ * fdatasync(), so a single sync covers many commits (group commit).
+ * Optionally the writer lingers up to group_usecs after the first record
+ * of a batch, trading commit latency for fewer, larger syncs.
+ *
+ * Positions in the log (LSNs) are byte offsets just past a record. Each
+ * record is a header {magic, count, checksum} and count <key,data> pairs,
+ * data NOT_IN_TREE meaning remove. A torn or corrupt tail, as a crash
+ * leaves it, ends replay and is cut off before appending resumes.
+ */
+class RedoLog {
+  public:
+    /*
+     * Replays the records already in path into p_tree with Set/Remove,
+     * then keeps appending to it. Returns NULL if path cannot be opened.
+     */
+    static RedoLog * Open( const char * path, LogDurability durability, int group_usecs, ConcurrentTree * p_tree );
+    ~RedoLog();   /* Writes and syncs everything queued */
+
+    /* Queues one transaction's writes; returns its LSN */
+    uint64_t Append( const std::map<int,int> &writes );
+
+    /* End of everything queued so far */
+    uint64_t Appended();
+
+    /* Returns once lsn is on disk; at once under LOG_ASYNC_COMMIT */
+    void WaitDurable( uint64_t lsn );
+
+    uint64_t Replayed() const { return m_nReplayed; }    /* Transactions found by Open */
+    uint64_t Records() const { return m_nRecords.load(); }  /* Transactions appended since */
+    uint64_t Syncs() const   { return m_nSyncs.load(); }
+
+  private:
+    RedoLog( int fd, uint64_t end, uint64_t replayed, LogDurability durability, int group_usecs );
+    void Writer();
+
+    int m_fd;
+    LogDurability m_durability;
+    int m_nGroupUsecs;
+    uint64_t m_nReplayed;
+
+    std::mutex m_l_log;                /* Guards the fields up to m_bStopping */
+    std::condition_variable m_queued;  /* Writer waits here for records */
+    std::condition_variable m_synced;  /* Committers wait here for m_nDurable */
+    std::vector<char> m_buffer;        /* Records not handed to the writer yet */
+    uint64_t m_nAppended;
+    bool m_bStopping;
+
+    std::atomic<uint64_t> m_nDurable;  /* Read without the lock on the fast path */
+    std::atomic<uint64_t> m_nRecords, m_nSyncs;
+    std::thread * m_p_writer;
+};
+
+#endif // #ifndef REDOLOG_H
@@ -0,0 +1,77 @@
+#ifndef SKIPLIST_H
+#define SKIPLIST_H
+
+#include <atomic>
+#include <iostream>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+class EpochManager;
+class NodePool;
+
+/*
+ * A lock-free skip list mapping int keys to int data, after Herlihy and
+ * Shavit's LockFreeSkipList. Every level is a sorted singly-linked list.
+ * The low bit of a node's link at some level is a mark: once set, that
+ * link is frozen and the node is on its way out of that level. Searches
+ * that meet a marked node unlink it with a CAS on its predecessor.
+ *
+ * Remove takes effect when it swaps the node's data to NOT_IN_TREE; it
+ * then marks the tower top-down and searches once more to unlink it. Set
+ * on a live key swaps the data in place. A new node is linked bottom-up
+ * and may only be marked once all of its levels are in, so a Set or
+ * Remove that meets a node whose insertion has not finished waits for it.
+ *
+ * Lookups never write shared memory. Unlinked nodes are reclaimed through
+ * an EpochManager; every operation runs inside an epoch. Towers of up to
+ * SKIPLIST_SHORT_LEVELS (all but 1 in 256 nodes) fit one cache line and
+ * come from their own NodePool.
+ */
+const int SKIPLIST_MAX_LEVELS   = 16;
+const int SKIPLIST_SHORT_LEVELS = 4;
+
+class SkipList {
+  public:
+    SkipList();
+    ~SkipList();
+
+    int  Lookup( int key );
+    void Remove( int key );
+    void Set( int key, int data );
+
+    /* Replaces the contents with entries (ascending, distinct keys); no other operation may run */
+    void Load( const std::vector< std::pair<int,int> > &entries );
+
+    /* Appends live pairs with lo <= key <= hi, until out holds limit entries; each is current when visited */
+    void Collect( int lo, int hi, std::vector< std::pair<int,int> > &out, size_t limit );
+
+    void print( std::ostream &out );
+
+  private:
+    struct Node {
+        int key;
+        std::atomic<int> data;            /* NOT_IN_TREE once removed */
+        int height;
+        std::atomic<bool> fully_linked;   /* Set by the inserter after the top level is linked */
+        std::atomic<uintptr_t> next[SKIPLIST_MAX_LEVELS]; /* Only the first height exist */
+    };
+
+    Node * NewNode( int key, int data, int height );
+    static void FreeNode( void * p, void * p_list );
+    void FreeAll();
+
+    /* Fills preds/succs around key at every level, unlinking marked nodes on the way */
+    bool Find( int key, Node ** preds, Node ** succs );
+    /* First unmarked node with key >= key on the bottom level, or NULL; writes nothing */
+    Node * Seek( int key );
+    void LinkUpperLevels( Node * p_node, Node ** preds, Node ** succs );
+    static void MarkTower( Node * p_node );
+
+    Node * m_p_head;                      /* Full-height sentinel; its key is never compared */
+    EpochManager * m_p_epochs;
+    NodePool * m_p_shortPool;
+    NodePool * m_p_tallPool;
+};
+
+#endif // #ifndef SKIPLIST_H
@@ -0,0 +1,67 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+/*
+ * Read-only, memory-mapped image of a tree's <key,data> pairs. The file
+ * holds no pointers, only arrays at offsets derived from the pair count:
+ *
+ *   header page
+ *   index levels, top first: the first key of every page on the level below
+ *   leaf pages: SNAPSHOT_LEAF_PAIRS ascending (key,data) pairs each
+ *
+ * A lookup binary-searches one page per level, so it faults in about
+ * log_1024(n) + 1 pages and opening a snapshot reads nothing but the header.
+ *
+ * Removals of snapshot pairs are recorded in a bitmap in ordinary memory;
+ * its pages are zero until first written, so it too costs nothing up front.
+ */
+const size_t SNAPSHOT_PAGE_BYTES  = 4096;
+const int    SNAPSHOT_INDEX_FANOUT = SNAPSHOT_PAGE_BYTES / sizeof(int32_t);
+const int    SNAPSHOT_LEAF_PAIRS   = SNAPSHOT_PAGE_BYTES / ( 2 * sizeof(int32_t) );
+
+class TreeSnapshot {
+  public:
+    /* Writes pairs (ascending, distinct keys) to path; false if the file cannot be written */
+    static bool Write( const char * path, const std::vector< std::pair<int,int> > &pairs );
+
+    /* Maps path; NULL if it is missing or not a snapshot */
+    static TreeSnapshot * Open( const char * path );
+    ~TreeSnapshot();
+
+    int Count() const { return m_nPairs; }
+
+    /* Data of key, or NOT_IN_TREE if absent or removed */
+    int Lookup( int key ) const;
+
+    /* Hides key from now on; no-op if it is not in the snapshot */
+    void Remove( int key );
+
+    /* Appends live pairs with lo <= key <= hi, until out holds limit entries */
+    void Collect( int lo, int hi, std::vector< std::pair<int,int> > &out, size_t limit ) const;
+
+  private:
+    TreeSnapshot() {}
+
+    /* Position of the first pair with key >= key, in 0..m_nPairs */
+    int LowerBound( int key ) const;
+    bool IsRemoved( int index ) const;
+
+    const char * m_p_map;
+    size_t m_nMapBytes;
+    int m_nPairs;
+
+    int m_nLevels;
+    std::vector<const int32_t*> m_levels;     /* Top first */
+    std::vector<int> m_levelCounts;
+    const int32_t * m_p_pairs;                /* key, data, key, data, ... */
+
+    std::atomic<uint64_t> * m_p_removed;      /* One bit per pair */
+};
+
+#endif // #ifndef SNAPSHOT_H
@@ -1,33 +1,147 @@
 #ifndef STATS_H
 #define STATS_H
 
-#include <mutex>
+#include "PerfCounters.h"
+#include "system_specific.h"
+
+#include <stdint.h>
 #include <time.h>
+#include <sys/time.h>
+
+/*
+ * Statistics are kept per thread, each thread owning a cache-line-aligned
+ * slot, so counting never bounces a shared line between cores. Slots are
+ * only summed up by printStats(), which, like clearStats(), must be called
+ * while no transactions are running.
+ */
+const int STATS_MAX_THREADS = 256;
+
+/* One latency histogram per transaction type, indexed by the constants in Transactions.h */
+const int STATS_TXN_TYPES = 5;
+
+/*
+ * Log-linear buckets: values below 8ns get a bucket each, after that every
+ * power of two is split into 8 buckets (<= 12.5% error). The last bucket
+ * also takes anything above ~36 minutes.
+ */
+const int LATENCY_SUB_BITS = 3;
+const int LATENCY_BUCKETS  = 40 << LATENCY_SUB_BITS;
+
+/* Locks whose contention is profiled (-L), as reported by printStats() */
+enum LockSite {
+    LOCK_TREE_WRITE,   /* Write side of the tree RWLock (any -l policy), including the wait for readers to drain */
+    LOCK_TREE_READ,    /* Read side of the tree RWLock, including any wait behind writers */
+    LOCK_TRANSACTION,  /* ConcurrentTree::m_l_transLock (TXN_GLOBAL_LOCK) */
+    LOCK_BARRIER       /* SpinFutexBarrier::Arrive: the wait for the other arrivals; contended if it slept */
+};
+const int LOCK_SITES = 4;
+
+/* Contended: the lock could not be taken on the first try */
+struct LockCounts {
+    uint64_t acquired;
+    uint64_t contended;
+    uint64_t wait_nsecs;
+    uint64_t hold_nsecs;
+};
+
+struct ThreadStats {
+    int nScans;
+    int nUpdates;
+    int nLookups;
+    int nCAdds;
+    int nCRemoves;
+
+    int nScanAborts;
+    int nUpdateAborts;
+    int nLookupAborts;
+    int nCAddAborts;
+    int nCRemoveAborts;
+
+    int nAborts;
+    int nCommits;
+
+    uint64_t perf[PERF_EVENTS];   /* Summed over the thread's measured phases */
+    uint32_t perfOpened;          /* Bit e set if event e was counted */
+
+    uint64_t latency[STATS_TXN_TYPES][LATENCY_BUCKETS];
 
-extern std::mutex statslock;
+    LockCounts locks[LOCK_SITES];
+    uint64_t lockHeldSince[LOCK_SITES];   /* 0 while not held */
+} __attribute__(( aligned( CACHE_LINE_SIZE ) ));
 
-#define INCREMENT_STAT( name ) { statslock.lock(); name++; statslock.unlock(); }
+extern __thread ThreadStats * t_p_stats;
+ThreadStats * registerStatsThread();
 
-extern int nScans;
-extern int nUpdates;
-extern int nLookups;
-extern int nCAdds;
-extern int nCRemoves;
+inline ThreadStats * myStats() {
+    if( t_p_stats == NULL ) t_p_stats = registerStatsThread();
+    return t_p_stats;
+}
 
-extern int nScanAborts;
-extern int nUpdateAborts;
-extern int nLookupAborts;
-extern int nCAddAborts;
-extern int nCRemoveAborts;
+inline uint64_t statsNow() {
+    struct timespec ts;
+    clock_gettime( CLOCK_MONOTONIC, &ts );
+    return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void recordLatency( int type, uint64_t nsecs );
+
+/*
+ * Set before any thread starts. When clear, each profiled acquisition
+ * costs one predictable branch and reads no clock.
+ */
+extern bool lockProfiling;
+
+/* Call before trying to take the lock; pass the result to lockAcquired() */
+inline uint64_t lockWaitStart() {
+    return __builtin_expect( lockProfiling, 0 ) ? statsNow() : 0;
+}
+
+inline void lockAcquired( int site, uint64_t wait_start, bool contended ) {
+    if( __builtin_expect( !lockProfiling, 1 ) ) return;
+    ThreadStats * p_stats = myStats();
+    uint64_t now = statsNow();
+    LockCounts &counts = p_stats->locks[site];
+    counts.acquired++;
+    if( contended ) counts.contended++;
+    counts.wait_nsecs += now - wait_start;
+    p_stats->lockHeldSince[site] = now;
+}
+
+inline void lockReleased( int site ) {
+    if( __builtin_expect( !lockProfiling, 1 ) ) return;
+    ThreadStats * p_stats = myStats();
+    if( p_stats->lockHeldSince[site] == 0 ) return;   /* Taken before clearStats() */
+    p_stats->locks[site].hold_nsecs += statsNow() - p_stats->lockHeldSince[site];
+    p_stats->lockHeldSince[site] = 0;
+}
+
+#define INCREMENT_STAT( name ) { myStats()->name++; }
+#define RECORD_LATENCY( type, start_nsecs ) { recordLatency( (type), statsNow() - (start_nsecs) ); }
 
 extern struct timeval starttime;
 extern struct timeval endtime;
 
-extern int nAborts;
-extern int nCommits;
-
 void clearStats();
 void printStats();
 
+/* Sums every thread's slot into sum */
+void collectStats( ThreadStats &sum );
+uint64_t latencySamples( const ThreadStats &sum, int type );
+/* Upper bound, in usecs, of the bucket holding the given fraction of type's samples */
+double latencyPercentile( const ThreadStats &sum, int type, double fraction );
+/* Lock sites by total wait, each with the thread that waited longest; printed by printStats() with -L */
+void printLockProfile();
+const char * lockSiteName( int site );
+
+/* Average count of event per committed transaction, or -1 if it was not counted */
+double perfPerTransaction( const ThreadStats &sum, int event );
+
+/* Counts the calling thread's events from here to stopPerfCounters(), into its statistics */
+void startPerfCounters();
+void stopPerfCounters();
+
+/* Lets new threads reuse the slots; only once every thread that recorded statistics has exited */
+void resetStatsThreads();
+
 #endif
 
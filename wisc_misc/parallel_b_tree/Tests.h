@@ -1,8 +1,9 @@
 #ifndef TESTS_H
 #define TESTS_H
 
-class PThreadLockCVBarrier;
-class ConcurrentTree;
+#include "CTree.h"
+
+class ThreadBarrier;
 
 /* 
  * Don't make this bigger than, say, 100000 or the default parallel implementation
@@ -16,10 +17,13 @@ const int NUM_ELEMENTS_THROUGHPUT = NUM_ELEMENTS;
  */
 const int NUM_TRANSACTIONS = 1000;
 
-bool testTreeSerial();
-bool testTreeParallel( ConcurrentTree * p_tree, int tid, int nThreads, PThreadLockCVBarrier& barrier );
-bool testTreeTransactional( ConcurrentTree * p_tree, int tid, int nThreads, PThreadLockCVBarrier& barrier );
-bool testTreeThroughput( ConcurrentTree * p_tree, int tid, int nThreads, PThreadLockCVBarrier& barrier );
+bool testTreeSerial( const TreeConfig &config );
+bool testTreeParallel( ConcurrentTree * p_tree, int tid, int nThreads, ThreadBarrier& barrier );
+bool testTreeTransactional( ConcurrentTree * p_tree, int tid, int nThreads, ThreadBarrier& barrier );
+bool testTreeThroughput( ConcurrentTree * p_tree, int tid, int nThreads, ThreadBarrier& barrier );
+
+/* Sets keys lb..ub-1 to themselves, in an order that keeps an unbalanced tree balanced */
+void loadTreeRange( ConcurrentTree * p_tree, int lb, int ub );
 
 #endif
 
@@ -0,0 +1,99 @@
+#ifndef THREADSLOTS_H
+#define THREADSLOTS_H
+
+#include "system_specific.h"
+#include "fatals.h"
+
+#include <atomic>
+#include <pthread.h>
+#include <stdint.h>
+
+/*
+ * Fixed table of per-thread state belonging to one object, e.g. the
+ * reclamation state an EpochManager keeps for each thread. A thread is
+ * given a slot the first time it asks and the same slot from then on;
+ * slots are never given back. Each slot is padded to its own cache lines.
+ *
+ * Mine() first looks in a one-entry thread-local cache keyed by a table id
+ * that is never reused, since threads usually work on a single tree at a
+ * time; on a miss it scans the slots handed out so far.
+ */
+inline uint64_t nextThreadSlotsID() {
+    static std::atomic<uint64_t> nextID( 1 );
+    return nextID.fetch_add( 1 );
+}
+
+template <class Slot>
+class ThreadSlots {
+  public:
+    /* what names the owner in the error given when more than max_threads threads ask */
+    ThreadSlots( int max_threads, const char * what ) {
+        m_nID = nextThreadSlotsID();
+        m_nMax = max_threads;
+        m_szWhat = what;
+        m_nClaimed.store( 0 );
+        m_p_entries = new Entry[max_threads];
+        for( int i=0;i<max_threads;i++ ) {
+            m_p_entries[i].claimed.store( false );
+        }
+    }
+
+    ~ThreadSlots() {
+        delete [] m_p_entries;
+    }
+
+    Slot * Mine() {
+        static thread_local uint64_t t_nCachedID = 0;
+        static thread_local Slot * t_p_cached = NULL;
+        if( t_nCachedID == m_nID ) return t_p_cached;
+
+        pthread_t self = pthread_self();
+        Slot * p_slot = NULL;
+
+        int nClaimed = Claimed();
+        for( int i=0;i<nClaimed;i++ ) {
+            if( m_p_entries[i].claimed.load() && pthread_equal( m_p_entries[i].owner, self ) ) {
+                p_slot = &m_p_entries[i].slot;
+            }
+        }
+
+        if( p_slot == NULL ) {
+            int index = m_nClaimed.fetch_add( 1 );
+            if( index >= m_nMax ) {
+                fatal("More than %i threads used one %s\n", m_nMax, m_szWhat );
+            }
+            m_p_entries[index].owner = self;
+            m_p_entries[index].claimed.store( true );
+            p_slot = &m_p_entries[index].slot;
+        }
+
+        t_nCachedID = m_nID;
+        t_p_cached = p_slot;
+        return p_slot;
+    }
+
+    /* Slots 0..Claimed()-1 have been handed out; Capacity() exist */
+    int Claimed() const {
+        int nClaimed = m_nClaimed.load();
+        return nClaimed < m_nMax ? nClaimed : m_nMax;
+    }
+    int Capacity() const { return m_nMax; }
+
+    Slot & operator[]( int index ) { return m_p_entries[index].slot; }
+
+  private:
+    struct Entry {
+        Slot slot;
+        std::atomic<bool> claimed;
+        pthread_t owner;
+        char m_pad[CACHE_LINE_SIZE];
+    };
+
+    uint64_t m_nID;
+    int m_nMax;
+    const char * m_szWhat;
+    std::atomic<int> m_nClaimed;
+    Entry * m_p_entries;
+};
+
+#endif // #ifndef THREADSLOTS_H
@@ -1,6 +1,7 @@
 #ifndef TRANSACTIONS_H
 #define TRANSACTIONS_H
 
+#include <stdint.h>
 #include <unistd.h>
 
 using namespace std;
@@ -8,11 +9,13 @@ using namespace std;
 class ConcurrentTree;
 
 /* Defines the names of the transactions */
-const char SCAN               = 0;
-const char UPDATE             = 1;
-const char LOOKUP             = 2;
-const char CONDITIONAL_ADD    = 3;
-const char CONDITIONAL_REMOVE = 4;
+const int SCAN                = 0;
+const int UPDATE              = 1;
+const int LOOKUP              = 2;
+const int CONDITIONAL_ADD     = 3;
+const int CONDITIONAL_REMOVE  = 4;
+
+/* Defaults for the runtime Workload (see Workload.h) */
 
 /* Defines the relative likelyhood of a given transaction -- the higher the more likely the transaction */
 const int SCAN_WEIGHT               = 1;
@@ -32,7 +35,7 @@ const useconds_t INTER_TRANSACTION_SLEEP_TIME = 10000;
 const int SMALL_TRANSACTION_SIZE = 20;
 
 void initSeed (int thread_id);
-char randomTransaction();
+int  randomTransaction();
 
 int  doTortureScan( ConcurrentTree * p_tree );
 void doTortureUpdate( ConcurrentTree * p_tree );
@@ -46,5 +49,11 @@ int  doLookup( ConcurrentTree * p_tree );
 void doConditionalAdd( ConcurrentTree * p_tree );
 void doConditionalRemove( ConcurrentTree * p_tree );
 
+/* Runs one of the above by type, counting it and its latency in the stats; false if type is unknown */
+bool doTransaction( ConcurrentTree * p_tree, int type );
+
+/* Same, but latency is measured from start_nsecs (statsNow() time), e.g. when the transaction was due */
+bool doTransactionSince( ConcurrentTree * p_tree, int type, uint64_t start_nsecs );
+
 
 #endif // #ifndef TRANSACTIONS_H
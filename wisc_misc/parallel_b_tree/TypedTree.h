@@ -0,0 +1,271 @@
+#ifndef TYPEDTREE_H
+#define TYPEDTREE_H
+
+#include "NodePool.h"
+#include "RWLock.h"
+
+#include <functional>
+#include <new>
+#include <stdint.h>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/*
+ * TypedTree<K,V,Compare>: an unbalanced binary tree map for any key and
+ * value type, ordered by Compare. Lookup reports presence separately, so
+ * no value has to be given up as a sentinel the way ConcurrentTree gives
+ * up NOT_IN_TREE. Atomic operations run under one tree-wide RWLock of the
+ * chosen policy; nodes come from a NodePool.
+ *
+ * ConcurrentTree stays the int/int tree with all its synchronization
+ * modes. TypedTree is for 64-bit ids, strings and the like.
+ */
+
+/*
+ * How a key is stored in a node and compared against a search key. The
+ * primary template stores K itself and asks Compare. Trivially copyable
+ * keys of up to two words are passed by value rather than by reference.
+ */
+template <class K, class Compare>
+struct TreeKey {
+    typedef typename std::conditional< std::is_trivially_copyable<K>::value && sizeof(K) <= 2 * sizeof(void*),
+                                       K, const K & >::type arg_type;
+
+    /* A search key, prepared once per operation */
+    struct Probe {
+        explicit Probe( arg_type k ) : key( k ) {}
+        arg_type key;
+    };
+
+    explicit TreeKey( const Probe &probe ) : key( probe.key ) {}
+
+    /* <0, 0 or >0 as probe orders before, equal to or after stored */
+    static int Order( const Probe &probe, const TreeKey &stored ) {
+        Compare less;
+        if( less( probe.key, stored.key ) ) return -1;
+        if( less( stored.key, probe.key ) ) return 1;
+        return 0;
+    }
+
+    const K & Get() const { return key; }
+
+    K key;
+};
+
+/*
+ * Strings in their natural order also keep their first 8 bytes as a
+ * big-endian integer. Keys that differ there, which is most of them, are
+ * ordered by one integer compare without loading the characters.
+ */
+template <>
+struct TreeKey< std::string, std::less<std::string> > {
+    typedef const std::string & arg_type;
+
+    struct Probe {
+        explicit Probe( const std::string &k ) : key( k ), prefix( Prefix( k ) ) {}
+        const std::string &key;
+        uint64_t prefix;
+    };
+
+    explicit TreeKey( const Probe &probe ) : prefix( probe.prefix ), key( probe.key ) {}
+
+    static int Order( const Probe &probe, const TreeKey &stored ) {
+        if( probe.prefix != stored.prefix ) return probe.prefix < stored.prefix ? -1 : 1;
+        return probe.key.compare( stored.key );
+    }
+
+    static uint64_t Prefix( const std::string &s ) {
+        uint64_t prefix = 0;
+        for( size_t i=0;i<8;i++ ) {
+            prefix <<= 8;
+            if( i < s.size() ) prefix |= (unsigned char) s[i];
+        }
+        return prefix;
+    }
+
+    const std::string & Get() const { return key; }
+
+    uint64_t prefix;
+    std::string key;
+};
+
+template <class K, class V, class Compare = std::less<K> >
+class TypedTree {
+  public:
+    typedef TreeKey<K,Compare> Key;
+    typedef typename Key::arg_type key_arg;
+
+    /* Receives each pair of a scan, in key order */
+    typedef void (*Callback)( const K &key, const V &data, void * p_arg );
+
+    TypedTree( RWLockPolicy policy = RWLOCK_COUNTING );
+    ~TypedTree();
+
+    /* Returns false, leaving data alone, if key is absent */
+    bool Lookup( key_arg key, V &data );
+    void Set( key_arg key, const V &data );
+    /* Returns false if key was absent */
+    bool Remove( key_arg key );
+
+    /* As ConcurrentTree::Scan: a consistent snapshot, callbacks run after the tree is released */
+    void Scan( key_arg lo, key_arg hi, Callback callback, void * p_arg );
+
+  private:
+    struct Node {
+        Node( const typename Key::Probe &probe, const V &data ) : m_p_left( NULL ), m_p_right( NULL ),
+                                                                  m_key( probe ), m_data( data ) {}
+        Node * m_p_left, * m_p_right;
+        Key m_key;
+        V m_data;
+    };
+
+    Node ** FindLink( const typename Key::Probe &probe );
+
+    /* Nodes that need no destructor are left to the pool's bulk free */
+    void DestroyAll( std::true_type ) {}
+    void DestroyAll( std::false_type );
+
+    Node * p_root;
+    RWLock * m_p_treeLock;
+    NodePool * m_p_nodePool;
+};
+
+////////////////////////////////////////////////////////////////
+
+template <class K, class V, class Compare>
+TypedTree<K,V,Compare>::TypedTree( RWLockPolicy policy ) {
+    p_root = NULL;
+    m_p_treeLock = RWLock::Create( policy );
+    m_p_nodePool = new NodePool( sizeof( Node ) );
+}
+
+template <class K, class V, class Compare>
+TypedTree<K,V,Compare>::~TypedTree() {
+    DestroyAll( std::is_trivially_destructible<Node>() );
+    p_root = NULL;
+
+    delete m_p_nodePool;
+    m_p_nodePool = NULL;
+    delete m_p_treeLock;
+    m_p_treeLock = NULL;
+}
+
+template <class K, class V, class Compare>
+void TypedTree<K,V,Compare>::DestroyAll( std::false_type ) {
+    std::vector<Node*> pending;
+    if( p_root != NULL ) pending.push_back( p_root );
+    while( !pending.empty() ) {
+        Node * p_node = pending.back();
+        pending.pop_back();
+        if( p_node->m_p_left  != NULL ) pending.push_back( p_node->m_p_left );
+        if( p_node->m_p_right != NULL ) pending.push_back( p_node->m_p_right );
+        p_node->~Node();
+    }
+}
+
+/* The link that points, or would point, at the node holding probe */
+template <class K, class V, class Compare>
+typename TypedTree<K,V,Compare>::Node ** TypedTree<K,V,Compare>::FindLink( const typename Key::Probe &probe ) {
+    Node ** pp_link = &p_root;
+    while( *pp_link != NULL ) {
+        int order = Key::Order( probe, (*pp_link)->m_key );
+        if( order == 0 ) break;
+        pp_link = ( order < 0 ) ? &(*pp_link)->m_p_left : &(*pp_link)->m_p_right;
+    }
+    return pp_link;
+}
+
+template <class K, class V, class Compare>
+bool TypedTree<K,V,Compare>::Lookup( key_arg key, V &data ) {
+    typename Key::Probe probe( key );
+
+    m_p_treeLock->ReadLock();
+    Node * p_node = *FindLink( probe );
+    if( p_node != NULL ) data = p_node->m_data;
+    m_p_treeLock->ReadUnlock();
+
+    return p_node != NULL;
+}
+
+template <class K, class V, class Compare>
+void TypedTree<K,V,Compare>::Set( key_arg key, const V &data ) {
+    typename Key::Probe probe( key );
+
+    m_p_treeLock->WriteLock();
+    Node ** pp_link = FindLink( probe );
+    if( *pp_link != NULL ) {
+        (*pp_link)->m_data = data;
+    } else {
+        *pp_link = new( m_p_nodePool->Allocate() ) Node( probe, data );
+    }
+    m_p_treeLock->WriteUnlock();
+}
+
+/* A node with two children is replaced by its predecessor, relinked rather than copied */
+template <class K, class V, class Compare>
+bool TypedTree<K,V,Compare>::Remove( key_arg key ) {
+    typename Key::Probe probe( key );
+
+    m_p_treeLock->WriteLock();
+    Node ** pp_link = FindLink( probe );
+    Node * p_dead = *pp_link;
+    if( p_dead == NULL ) {
+        m_p_treeLock->WriteUnlock();
+        return false;
+    }
+
+    if( p_dead->m_p_left == NULL ) {
+        *pp_link = p_dead->m_p_right;
+    } else if( p_dead->m_p_right == NULL ) {
+        *pp_link = p_dead->m_p_left;
+    } else {
+        Node ** pp_pred = &p_dead->m_p_left;
+        while( (*pp_pred)->m_p_right != NULL ) pp_pred = &(*pp_pred)->m_p_right;
+
+        Node * p_pred = *pp_pred;
+        *pp_pred = p_pred->m_p_left;
+        p_pred->m_p_left  = p_dead->m_p_left;
+        p_pred->m_p_right = p_dead->m_p_right;
+        *pp_link = p_pred;
+    }
+
+    p_dead->~Node();
+    m_p_nodePool->Free( p_dead );
+    m_p_treeLock->WriteUnlock();
+    return true;
+}
+
+template <class K, class V, class Compare>
+void TypedTree<K,V,Compare>::Scan( key_arg lo, key_arg hi, Callback callback, void * p_arg ) {
+    typename Key::Probe lo_probe( lo );
+    typename Key::Probe hi_probe( hi );
+    std::vector< std::pair<K,V> > entries;
+
+    /* In-order walk with an explicit stack: an unbalanced tree can be very deep */
+    m_p_treeLock->ReadLock();
+    std::vector<Node*> pending;
+    Node * p_node = p_root;
+    while( p_node != NULL || !pending.empty() ) {
+        while( p_node != NULL ) {
+            int order = Key::Order( lo_probe, p_node->m_key );
+            if( order <= 0 ) pending.push_back( p_node );
+            p_node = ( order < 0 ) ? p_node->m_p_left : ( order > 0 ) ? p_node->m_p_right : NULL;
+        }
+        if( pending.empty() ) break;
+
+        p_node = pending.back();
+        pending.pop_back();
+        if( Key::Order( hi_probe, p_node->m_key ) < 0 ) break;
+        entries.push_back( std::make_pair( p_node->m_key.Get(), p_node->m_data ) );
+        p_node = p_node->m_p_right;
+    }
+    m_p_treeLock->ReadUnlock();
+
+    for( size_t i=0;i<entries.size();i++ ) {
+        callback( entries[i].first, entries[i].second, p_arg );
+    }
+}
+
+#endif // #ifndef TYPEDTREE_H
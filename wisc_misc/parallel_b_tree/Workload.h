@@ -0,0 +1,65 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include "CTree.h"
+#include "Tests.h"
+#include "Transactions.h"
+
+#include <unistd.h>
+
+/* How the keys touched by the non-torture transactions are picked */
+enum KeyDistribution {
+    KEYS_UNIFORM,
+    KEYS_ZIPFIAN,     /* Key k is drawn with probability ~ 1/(k+1)^theta: low keys are hot */
+    KEYS_SEQUENTIAL,  /* Each thread walks the key space in order from its own starting point */
+    KEYS_HOTSPOT      /* hot_probability of accesses go to the lowest hot_fraction of keys */
+};
+
+/*
+ * Runtime knobs for the transactions in Transactions.C. The defaults are the
+ * historical compile-time constants, so the cTree harness behaves as before;
+ * treeBench overrides them from its command line. The torture transactions
+ * only honour the mix, since their correctness checks depend on the rest.
+ */
+struct Workload {
+    Workload();
+
+    int weights[5];               /* Indexed by SCAN, UPDATE, ... */
+    int num_elements;
+    int txn_size;                 /* Keys per update/lookup transaction; must be even */
+    useconds_t atomic_sleep;      /* Between accesses within a transaction */
+    useconds_t txn_sleep;         /* Between transactions */
+
+    KeyDistribution keys;
+    double zipf_theta;
+    double hot_fraction;
+    double hot_probability;
+
+    int WeightSum() const;
+
+    /* Validates the knobs and precomputes distribution constants; call after any change */
+    void Prepare();
+
+    /* Internal: Zipfian constants (Gray et al., "Quickly generating billion-record synthetic databases") */
+    double m_zeta;
+    double m_alpha;
+    double m_eta;
+};
+
+extern Workload workload;
+
+void initKeyGenerator( int thread_id );
+int  nextKey();
+
+/* Parses the -e/-s/-t/-l/-P tree options shared by cTree and treeBench; false if arg is unknown */
+bool parseTreeOption( int opt, const char * arg, TreeConfig &config );
+const char * engineName( TreeEngine engine );
+const char * syncName( SyncMode sync );
+const char * txnName( TxnMode txn );
+const char * rwlockName( RWLockPolicy rwlock );
+
+/* Parses the -W redo log durability: group[:usecs] or async */
+bool parseLogDurability( const char * arg, LogDurability &durability, int &group_usecs );
+const char * logDurabilityName( LogDurability durability );
+
+#endif // #ifndef WORKLOAD_H
@@ -1,10 +1,23 @@
 #ifndef SYSTEM_SPECIFIC_H
 #define SYSTEM_SPECIFIC_H
 
+#include <thread>
+
 #if (defined (__i386__) || defined (__x86_64__))
 #define PAUSE __asm__ __volatile__ ("pause")
 #else
 #define PAUSE
 #endif
 
+/* Hint that p will be read soon; batched descents issue these for their next node */
+#define PREFETCH(p) __builtin_prefetch( (p) )
+
+/* Coherence granularity; used to size and pad shared structures */
+#define CACHE_LINE_SIZE 64
+
+/* More threads than processors: a spinning waiter would hold the CPU the one it waits for needs */
+inline bool oversubscribed( int nThreads ) {
+    return nThreads > (int) std::thread::hardware_concurrency();
+}
+
 #endif // SYSTEM_SPECIFIC_H